@@ -2,11 +2,13 @@ package com.reveny.nativekeyattestation;
 
 import androidx.appcompat.app.AppCompatActivity;
 
+import android.os.Build;
 import android.os.Bundle;
 import android.widget.TextView;
 
 public class MainActivity extends AppCompatActivity {
     public native String getAttestationResult();
+    public native String getParallelAttestationResult();
 
     @Override
     protected void onCreate(Bundle savedInstanceState) {
@@ -15,7 +17,11 @@ public class MainActivity extends AppCompatActivity {
         System.loadLibrary("Attestation");
 
         TextView view = findViewById(R.id.result_text);
-        String result = getAttestationResult();
-        view.setText(result);
+        // Key generation blocks for seconds (StrongBox the longest), keep it off the main thread.
+        new Thread(() -> {
+            // StrongBox requires Android 9, attest it alongside the TEE when it can exist.
+            String result = Build.VERSION.SDK_INT >= Build.VERSION_CODES.P ? getParallelAttestationResult() : getAttestationResult();
+            runOnUiThread(() -> view.setText(result));
+        }, "Attestation").start();
     }
 }
\ No newline at end of file
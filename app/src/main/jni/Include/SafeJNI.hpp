@@ -3,6 +3,14 @@
 //
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Logger.hpp"
+
 #define THROW_JNI_EXCEPTIONS 1
 
 #define SAFE_FIND_CLASS(env, name) SafeJNI::FindClass(env, name);
@@ -16,8 +24,87 @@
 #define SAFE_JNI_CHECK_VALUE(env, val) if (env->ExceptionCheck()) { env->ExceptionClear(); return val; }
 
 namespace SafeJNI {
+    // Threads attached from native code resolve classes through the system class loader,
+    // which cannot see classes bundled with the app (e.g. BouncyCastle).
+    // Written once by CacheClassLoader, loadClassMethod is stored first so a published loader can always be used.
+    inline std::atomic<jobject> appClassLoader = nullptr;
+    inline std::atomic<jmethodID> loadClassMethod = nullptr;
+
+    // Classes that only the app class loader could resolve, as global references.
+    inline std::mutex classCacheMutex;
+    inline std::unordered_map<std::string, jclass> classCache;
+
+    // Returns whether the loader is available, a failed attempt is retried on the next call.
+    inline bool CacheClassLoader(JNIEnv* env, const char* anchorClass) {
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (appClassLoader != nullptr) return true;
+
+        jclass anchor = env->FindClass(anchorClass);
+        if (!anchor || env->ExceptionCheck()) {
+            env->ExceptionClear();
+            LOGE("CacheClassLoader -> Cannot find %s", anchorClass);
+            return false;
+        }
+
+        jclass classClass = env->FindClass("java/lang/Class");
+        jmethodID getClassLoaderMethod = env->GetMethodID(classClass, "getClassLoader", "()Ljava/lang/ClassLoader;");
+        jobject loader = env->CallObjectMethod(anchor, getClassLoaderMethod);
+        if (!loader || env->ExceptionCheck()) {
+            env->ExceptionClear();
+            LOGE("CacheClassLoader -> Cannot get the class loader of %s", anchorClass);
+            return false;
+        }
+
+        jclass classLoaderClass = env->FindClass("java/lang/ClassLoader");
+        jmethodID method = env->GetMethodID(classLoaderClass, "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;");
+        if (!method || env->ExceptionCheck()) {
+            env->ExceptionClear();
+            LOGE("CacheClassLoader -> ClassLoader.loadClass not found");
+            return false;
+        }
+
+        jobject globalLoader = env->NewGlobalRef(loader);
+        if (globalLoader == nullptr) return false;
+
+        loadClassMethod = method;
+        appClassLoader = globalLoader;
+        return true;
+    }
+
     inline jclass FindClass(JNIEnv* env, const char* name) {
+        // The decoders look classes up for every ASN.1 element, on attached threads each miss would throw first.
+        {
+            std::lock_guard<std::mutex> lock(classCacheMutex);
+            auto it = classCache.find(name);
+            if (it != classCache.end()) {
+                return (jclass)env->NewLocalRef(it->second);
+            }
+        }
+
         jclass clazz = env->FindClass(name);
+        jobject loader = appClassLoader.load();
+        if (!clazz && loader != nullptr) {
+            env->ExceptionClear();
+
+            std::string binaryName(name);
+            std::replace(binaryName.begin(), binaryName.end(), '/', '.');
+            jstring jName = env->NewStringUTF(binaryName.c_str());
+            clazz = (jclass)env->CallObjectMethod(loader, loadClassMethod.load(), jName);
+            env->DeleteLocalRef(jName);
+            if (env->ExceptionCheck()) {
+                env->ExceptionClear();
+                clazz = nullptr;
+            }
+
+            if (clazz) {
+                std::lock_guard<std::mutex> lock(classCacheMutex);
+                if (classCache.find(name) == classCache.end()) {
+                    classCache.emplace(name, (jclass)env->NewGlobalRef(clazz));
+                }
+            }
+        }
+
         if (!clazz) {
             if (THROW_JNI_EXCEPTIONS) env->ThrowNew(env->FindClass("java/lang/ClassNotFoundException"), name);
             return nullptr;
@@ -5,6 +5,8 @@
 
 #include <jni.h>
 #include <string>
+#include <set>
+#include <vector>
 #include <stdio.h>
 
 #include "Include/SafeJNI.hpp"
@@ -22,6 +24,17 @@ namespace Asn1Utils {
         return (jbyteArray)env->CallObjectMethod(asn1Encodable, getOctetsMethod);
     }
 
+    // Copies the octets out so callers never hold a local reference past the current native call.
+    inline std::vector<jbyte> GetBytesFromAsn1(JNIEnv *env, jobject asn1Encodable) {
+        jbyteArray array = GetByteArrayFromAsn1(env, asn1Encodable);
+        if (array == nullptr || env->ExceptionCheck()) return {};
+
+        std::vector<jbyte> bytes(env->GetArrayLength(array));
+        env->GetByteArrayRegion(array, 0, (jsize)bytes.size(), bytes.data());
+        env->DeleteLocalRef(array);
+        return bytes;
+    }
+
     inline jobject GetAsn1SequenceFromStream(JNIEnv* env, jobject asn1InputStream) {
         jclass asn1InputStreamClass = SAFE_FIND_CLASS(env, "org/bouncycastle/asn1/ASN1InputStream");
         jmethodID readObjectMethod = SAFE_GET_METHOD_ID(env, asn1InputStreamClass, "readObject", "()Lorg/bouncycastle/asn1/ASN1Primitive;");
@@ -40,6 +53,8 @@ namespace Asn1Utils {
         SAFE_FAILIURE_RETURN_VALUE(env, getOctetsMethod, nullptr);
 
         jbyteArray octets = static_cast<jbyteArray>(env->CallObjectMethod(asn1Primitive, getOctetsMethod));
+        SAFE_FAILIURE_RETURN_VALUE(env, octets, nullptr);
+
         jmethodID inputStreamID = SAFE_GET_METHOD_ID(env, asn1InputStreamClass, "<init>", "([B)V");
         jobject seqInputStream = env->NewObject(asn1InputStreamClass, inputStreamID, octets);
         SAFE_FAILIURE_RETURN_VALUE(env, seqInputStream, nullptr);
@@ -71,7 +86,7 @@ namespace Asn1Utils {
 
     inline jboolean GetBooleanFromAsn1(JNIEnv *env, jobject value) {
         jclass booleanClass = SAFE_FIND_CLASS(env, "org/bouncycastle/asn1/ASN1Boolean");
-        if (!env->IsInstanceOf(value, booleanClass)) {
+        if (value == nullptr || !env->IsInstanceOf(value, booleanClass)) {
             SAFE_THROW(env, "java/lang/IllegalArgumentException", "Expected boolean");
             return JNI_FALSE;
         }
@@ -96,7 +111,17 @@ namespace Asn1Utils {
         SAFE_FAILIURE_RETURN_VALUE(env, bigIntegerClass, 0);
 
         jmethodID intValueMethod = SAFE_GET_METHOD_ID(env, bigIntegerClass, "intValue", "()I");
-        SAFE_FAILIURE_RETURN_VALUE(env, intValueMethod, 0);
+        jmethodID signumMethod = SAFE_GET_METHOD_ID(env, bigIntegerClass, "signum", "()I");
+        jmethodID bitLengthMethod = SAFE_GET_METHOD_ID(env, bigIntegerClass, "bitLength", "()I");
+        SAFE_FAILIURE_RETURN_VALUE(env, bitLengthMethod, 0);
+
+        // intValue() truncates, 2^32 would otherwise decode as 0 (e.g. KM_VERIFIED_BOOT_VERIFIED).
+        if (bigInt == nullptr || env->CallIntMethod(bigInt, signumMethod) < 0 || env->CallIntMethod(bigInt, bitLengthMethod) > 31) {
+            if (!env->ExceptionCheck()) {
+                SAFE_THROW(env, "java/lang/IllegalArgumentException", "INTEGER out of bounds");
+            }
+            return 0;
+        }
 
         return env->CallIntMethod(bigInt, intValueMethod);
     }
@@ -106,7 +131,10 @@ namespace Asn1Utils {
         jclass enumeratedClass = SAFE_FIND_CLASS(env, "org/bouncycastle/asn1/ASN1Enumerated");
         SAFE_FAILIURE_RETURN_VALUE(env, enumeratedClass, 0);
 
-        if (env->IsInstanceOf(asn1Value, integerClass)) {
+        if (asn1Value == nullptr) {
+            SAFE_THROW(env, "java/lang/IllegalArgumentException", "Integer value expected");
+            return 0;
+        } else if (env->IsInstanceOf(asn1Value, integerClass)) {
             return BigIntegerToInt(env, env->CallObjectMethod(asn1Value, env->GetMethodID(integerClass, "getValue", "()Ljava/math/BigInteger;")));
         } else if (env->IsInstanceOf(asn1Value, enumeratedClass)) {
             return BigIntegerToInt(env, env->CallObjectMethod(asn1Value, env->GetMethodID(enumeratedClass, "getValue", "()Ljava/math/BigInteger;")));
@@ -118,7 +146,7 @@ namespace Asn1Utils {
 
     inline std::set<int> GetIntegersFromAsn1Set(JNIEnv* env, jobject set) {
         jclass setClass = SAFE_FIND_CLASS(env, "org/bouncycastle/asn1/ASN1Set");
-        if (!env->IsInstanceOf(set, setClass)) {
+        if (set == nullptr || !env->IsInstanceOf(set, setClass)) {
             SAFE_THROW(env, "java/lang/IllegalArgumentException", "Expected set");
             return std::set<int>(); // Return empty set to avoid further processing
         }
@@ -135,7 +163,10 @@ namespace Asn1Utils {
             jobject asn1Integer = env->CallObjectMethod(enumeration, nextElementMethod);
             if (env->ExceptionCheck()) break;
 
-            resultSet.insert(GetIntegerFromAsn1(env, asn1Integer));
+            int value = GetIntegerFromAsn1(env, asn1Integer);
+            if (env->ExceptionCheck()) break;
+
+            resultSet.insert(value);
         }
 
         return resultSet;
@@ -2,16 +2,21 @@
 // Created by reveny on 02/01/2024.
 //
 #include "KeyAttestation.hpp"
+#include "KeyStoreManager.hpp"
 #include "Include/Logger.hpp"
 #include <set>
+#include <stdexcept>
+#include <thread>
 
 namespace KeyAttestation {
-    jbyteArray attestationChallenge = nullptr;
-    std::string outData = {};
-    AttestationResult attestationResult = AttestationResult::CriticalError;
-
-    std::unique_ptr<Attest> softwareEnforced = nullptr;
-    std::unique_ptr<Attest> teeEnforced = nullptr;
+    thread_local std::vector<jbyte> attestationChallenge = {};
+    thread_local std::string outData = {};
+    thread_local AttestationResult attestationResult = AttestationResult::CriticalError;
+    thread_local SecurityLevel attestationSecurityLevel = SecurityLevel::Unknown;
+    thread_local bool attestationMalformed = false;
+
+    thread_local std::unique_ptr<Attest> softwareEnforced = nullptr;
+    thread_local std::unique_ptr<Attest> teeEnforced = nullptr;
 }
 
 jobject KeyAttestation::ParseAsn1Encodable(JNIEnv* env, jobject parser) {
@@ -22,13 +27,12 @@ jobject KeyAttestation::ParseAsn1Encodable(JNIEnv* env, jobject parser) {
     return env->CallObjectMethod(parser, readObjectMethod);
 }
 
-std::string KeyAttestation::VerifiedBootStateToString(int verifiedBootState) {
-    switch (verifiedBootState) {
-        case RootOfTrust::KM_VERIFIED_BOOT_VERIFIED: return "Verified";
-        case RootOfTrust::KM_VERIFIED_BOOT_SELF_SIGNED: return "Self-signed";
-        case RootOfTrust::KM_VERIFIED_BOOT_UNVERIFIED: return "Unverified";
-        case RootOfTrust::KM_VERIFIED_BOOT_FAILED: return "Failed";
-        default: return "Unknown (" + std::to_string(verifiedBootState) + ")";
+std::string KeyAttestation::SecurityLevelToString(SecurityLevel securityLevel) {
+    switch (securityLevel) {
+        case SecurityLevel::Software: return "Software";
+        case SecurityLevel::TrustedEnvironment: return "TEE";
+        case SecurityLevel::StrongBox: return "StrongBox";
+        default: return "Unknown (" + std::to_string(securityLevel) + ")";
     }
 }
 
@@ -63,26 +67,62 @@ jobject KeyAttestation::GetAttestationSequence(JNIEnv* env, jobject x509Cert) {
 }
 
 void KeyAttestation::Asn1Attestation(JNIEnv* env, jobject cert) {
-    auto GetObjectAt = [env](jobject sequence, int index) -> jobject {
-        jclass sequenceClass = env->FindClass("org/bouncycastle/asn1/ASN1Sequence");
-        jmethodID getObjectAtMethod = env->GetMethodID(sequenceClass, "getObjectAt", "(I)Lorg/bouncycastle/asn1/ASN1Encodable;");
+    jobject seq = GetAttestationSequence(env, cert);
+    if (seq == nullptr || env->ExceptionCheck()) {
+        env->ExceptionClear();
+        attestationMalformed = true;
+        return;
+    }
+
+    ParseAttestationSequence(env, seq);
+}
+
+void KeyAttestation::ParseAttestationSequence(JNIEnv* env, jobject seq) {
+    // Only cleared again once every field below decoded, early returns leave the chain marked as malformed.
+    bool malformedBefore = attestationMalformed;
+    attestationMalformed = true;
+
+    jclass sequenceClass = SAFE_FIND_CLASS(env, "org/bouncycastle/asn1/ASN1Sequence");
+    SAFE_FAILIURE_RETURN_VOID(env, sequenceClass);
+
+    jmethodID sizeMethod = SAFE_GET_METHOD_ID(env, sequenceClass, "size", "()I");
+    SAFE_FAILIURE_RETURN_VOID(env, sizeMethod);
+
+    jmethodID getObjectAtMethod = SAFE_GET_METHOD_ID(env, sequenceClass, "getObjectAt", "(I)Lorg/bouncycastle/asn1/ASN1Encodable;");
+    SAFE_FAILIURE_RETURN_VOID(env, getObjectAtMethod);
+
+    jint size = env->CallIntMethod(seq, sizeMethod);
+    SAFE_JNI_CHECK(env);
+    if (size <= TEE_ENFORCED_INDEX) {
+        LOGE("ParseAttestationSequence -> Attestation sequence too short: %d", size);
+        return;
+    }
+
+    auto GetObjectAt = [env, getObjectAtMethod](jobject sequence, int index) -> jobject {
         return env->CallObjectMethod(sequence, getObjectAtMethod, index);
     };
 
-    jobject seq = GetAttestationSequence(env, cert);
-    SAFE_FAILIURE_RETURN_VOID(env, seq);
+    jobject securityLevelObj = GetObjectAt(seq, ATTESTATION_SECURITY_LEVEL_INDEX);
+    SAFE_FAILIURE_RETURN_VOID(env, securityLevelObj);
+    attestationSecurityLevel = (SecurityLevel) Asn1Utils::GetIntegerFromAsn1(env, securityLevelObj);
+    SAFE_JNI_CHECK(env);
 
     jobject challengeObj = GetObjectAt(seq, ATTESTATION_CHALLENGE_INDEX);
     SAFE_FAILIURE_RETURN_VOID(env, challengeObj);
-    attestationChallenge = Asn1Utils::GetByteArrayFromAsn1(env, challengeObj);
+    attestationChallenge = Asn1Utils::GetBytesFromAsn1(env, challengeObj);
+    SAFE_JNI_CHECK(env);
 
     jobject softwareObj = GetObjectAt(seq, SW_ENFORCED_INDEX);
     SAFE_FAILIURE_RETURN_VOID(env, softwareObj);
     softwareEnforced = std::make_unique<Attest>(env, softwareObj);
+    SAFE_JNI_CHECK(env);
 
     jobject teeObj = GetObjectAt(seq, TEE_ENFORCED_INDEX);
     SAFE_FAILIURE_RETURN_VOID(env, teeObj);
     teeEnforced = std::make_unique<Attest>(env, teeObj);
+    SAFE_JNI_CHECK(env);
+
+    attestationMalformed = malformedBefore;
 }
 
 void KeyAttestation::LoadFromCert(JNIEnv* env, jobject cert) {
@@ -112,6 +152,7 @@ void KeyAttestation::LoadFromCert(JNIEnv* env, jobject cert) {
     if (env->CallObjectMethod(cert, getExtensionValueMethod, eatOid) != nullptr) {
         if (env->CallObjectMethod(cert, getExtensionValueMethod, asn1Oid) != nullptr) {
             SAFE_THROW(env, "java/lang/IllegalArgumentException", "Multiple attestation extensions found");
+            return;
         }
     }
 
@@ -122,9 +163,20 @@ void KeyAttestation::LoadFromCert(JNIEnv* env, jobject cert) {
     Asn1Attestation(env, cert);
 }
 
+void KeyAttestation::ResetChainState() {
+    attestationChallenge.clear();
+    attestationResult = AttestationResult::CriticalError;
+    attestationSecurityLevel = SecurityLevel::Unknown;
+    attestationMalformed = false;
+    outData.clear();
+    softwareEnforced.reset();
+    teeEnforced.reset();
+}
+
 bool KeyAttestation::CheckAttestation(JNIEnv* env, jobject certificate) {
     try {
         LoadFromCert(env, certificate);
+        SAFE_JNI_CHECK_VALUE(env, false);
 
         if (!softwareEnforced || !teeEnforced) {
             LOGE("CheckAttestation -> Tee or Software is null %p %p", softwareEnforced.get(), teeEnforced.get());
@@ -141,7 +193,14 @@ bool KeyAttestation::CheckAttestation(JNIEnv* env, jobject certificate) {
 KeyAttestation::AttestationResult KeyAttestation::ParseCertificateChain(JNIEnv* env, jobjectArray certs) {
     SAFE_FAILIURE_RETURN_VALUE(env, certs, AttestationResult::Error);
 
+    // Nothing from an earlier chain on this thread may leak into this result.
+    ResetChainState();
+
     int size = env->GetArrayLength(certs);
+    if (size == 0) {
+        return AttestationResult::Error;
+    }
+
     jobject parent = env->GetObjectArrayElement(certs, size - 1);
     for (int i = size - 1; i >= 0; i--) {
         jobject current = env->GetObjectArrayElement(certs, i);
@@ -152,6 +211,13 @@ KeyAttestation::AttestationResult KeyAttestation::ParseCertificateChain(JNIEnv*
         }
     }
 
+    // Never fall back to the other authorization list when one of them failed to decode.
+    if (attestationMalformed) {
+        LOGE("ParseCertificateChain -> Attestation extension failed to decode");
+        attestationResult = AttestationResult::Error;
+        return attestationResult;
+    }
+
     // Software and Tee broken, return error.
     if (softwareEnforced.get() == nullptr && teeEnforced.get() == nullptr) {
         return AttestationResult::Error;
@@ -174,34 +240,34 @@ KeyAttestation::AttestationResult KeyAttestation::ParseCertificateChain(JNIEnv*
     return attestationResult;
 }
 
-void KeyAttestation::GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongBox, jboolean includeProps, jstring attestKeyAlias) {
+bool KeyAttestation::GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongBox, jboolean includeProps, jstring attestKeyAlias) {
     jclass dateClass = SAFE_FIND_CLASS(env, "java/util/Date");
     jmethodID dateConstructor = SAFE_GET_METHOD_ID(env, dateClass, "<init>", "()V");
     jobject now = env->NewObject(dateClass, dateConstructor);
-    SAFE_FAILIURE_RETURN_VOID(env, now);
+    SAFE_FAILIURE_RETURN_VALUE(env, now, false);
 
     jmethodID attestKeyID = SAFE_GET_METHOD_ID(env, env->GetObjectClass(alias), "equals", "(Ljava/lang/Object;)Z")
     jboolean attestKey = env->CallBooleanMethod(alias, attestKeyID, attestKeyAlias);
-    SAFE_JNI_CHECK(env);
+    SAFE_JNI_CHECK_VALUE(env, false);
 
     jint purposes = (android_get_device_api_level() >= 31 && attestKey) ? 128 : (4 | 8);
 
     jclass builderClass = SAFE_FIND_CLASS(env, "android/security/keystore/KeyGenParameterSpec$Builder");
     jmethodID builderConstructor = SAFE_GET_METHOD_ID(env, builderClass, "<init>", "(Ljava/lang/String;I)V");
     jobject builder = env->NewObject(builderClass, builderConstructor, alias, purposes);
-    SAFE_FAILIURE_RETURN_VOID(env, builder);
+    SAFE_FAILIURE_RETURN_VALUE(env, builder, false);
 
     jmethodID setAlgorithmParameterSpecMethod = SAFE_GET_METHOD_ID(env, builderClass, "setAlgorithmParameterSpec", "(Ljava/security/spec/AlgorithmParameterSpec;)Landroid/security/keystore/KeyGenParameterSpec$Builder;");
     jclass ecGenParameterSpecClass = SAFE_FIND_CLASS(env, "java/security/spec/ECGenParameterSpec");
     jmethodID ecGenParameterSpecConstructor = SAFE_GET_METHOD_ID(env, ecGenParameterSpecClass, "<init>", "(Ljava/lang/String;)V");
     jobject ecGenParameterSpec = env->NewObject(ecGenParameterSpecClass, ecGenParameterSpecConstructor, env->NewStringUTF("secp256r1"));
-    SAFE_FAILIURE_RETURN_VOID(env, ecGenParameterSpec);
+    SAFE_FAILIURE_RETURN_VALUE(env, ecGenParameterSpec, false);
 
     env->CallObjectMethod(builder, setAlgorithmParameterSpecMethod, ecGenParameterSpec);
 
     jclass stringClass = SAFE_FIND_CLASS(env, "java/lang/String");
     jobjectArray digests = env->NewObjectArray(1, stringClass, nullptr);
-    SAFE_FAILIURE_RETURN_VOID(env, digests);
+    SAFE_FAILIURE_RETURN_VALUE(env, digests, false);
     env->SetObjectArrayElement(digests, 0, env->NewStringUTF("SHA-256"));
 
     jmethodID setDigestsMethod = env->GetMethodID(builderClass, "setDigests", "([Ljava/lang/String;)Landroid/security/keystore/KeyGenParameterSpec$Builder;");
@@ -214,7 +280,7 @@ void KeyAttestation::GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongB
     jmethodID getBytesMethod = env->GetMethodID(env->FindClass("java/lang/String"), "getBytes", "()[B");
     jmethodID toStringID = SAFE_GET_METHOD_ID(env, dateClass, "toString", "()Ljava/lang/String;");
     jbyteArray challenge = (jbyteArray)env->CallObjectMethod(env->CallObjectMethod(now, toStringID), getBytesMethod);
-    SAFE_FAILIURE_RETURN_VOID(env, challenge);
+    SAFE_FAILIURE_RETURN_VALUE(env, challenge, false);
     env->CallObjectMethod(builder, setAttestationChallengeMethod, challenge);
 
     if (android_get_device_api_level() >= 28 && useStrongBox) {
@@ -238,7 +304,7 @@ void KeyAttestation::GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongB
             jclass x500PrincipalClass = env->FindClass("javax/security/auth/x500/X500Principal");
             jmethodID x500PrincipalConstructor = env->GetMethodID(x500PrincipalClass, "<init>", "(Ljava/lang/String;)V");
             jobject x500Principal = env->NewObject(x500PrincipalClass, x500PrincipalConstructor, env->NewStringUTF("CN=App Attest Key"));
-            SAFE_FAILIURE_RETURN_VOID(env, x500Principal);
+            SAFE_FAILIURE_RETURN_VALUE(env, x500Principal, false);
             env->CallObjectMethod(builder, setCertificateSubjectMethod, x500Principal);
         }
     }
@@ -246,7 +312,7 @@ void KeyAttestation::GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongB
     jclass keyPairGeneratorClass = SAFE_FIND_CLASS(env, "java/security/KeyPairGenerator");
     jmethodID getInstanceMethod = SAFE_GET_STATIC_METHOD_ID(env, keyPairGeneratorClass, "getInstance", "(Ljava/lang/String;Ljava/lang/String;)Ljava/security/KeyPairGenerator;");
     jobject keyPairGenerator = env->CallStaticObjectMethod(keyPairGeneratorClass, getInstanceMethod, env->NewStringUTF("EC"), env->NewStringUTF("AndroidKeyStore"));
-    SAFE_FAILIURE_RETURN_VOID(env, keyPairGenerator);
+    SAFE_FAILIURE_RETURN_VALUE(env, keyPairGenerator, false);
 
     jmethodID initializeMethod = SAFE_GET_METHOD_ID(env, keyPairGeneratorClass, "initialize", "(Ljava/security/spec/AlgorithmParameterSpec;)V");
     jmethodID buildMethod = SAFE_GET_METHOD_ID(env, builderClass, "build", "()Landroid/security/keystore/KeyGenParameterSpec;");
@@ -254,6 +320,9 @@ void KeyAttestation::GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongB
 
     jmethodID generateKeyPairMethod = SAFE_GET_METHOD_ID(env, keyPairGeneratorClass, "generateKeyPair", "()Ljava/security/KeyPair;");
     env->CallObjectMethod(keyPairGenerator, generateKeyPairMethod);
+    SAFE_JNI_CHECK_VALUE(env, false);
+
+    return true;
 }
 
 KeyAttestation::AttestationResult KeyAttestation::StartAttestation(JNIEnv* env, jboolean useStrongBox, jboolean includeProps, jboolean useAttestKey) {
@@ -271,31 +340,36 @@ KeyAttestation::AttestationResult KeyAttestation::StartAttestation(JNIEnv* env,
 
     jclass certClass = SAFE_FIND_CLASS(env, "java/security/cert/Certificate");
     jobjectArray certs = env->NewObjectArray(0, certClass, nullptr);
-    jstring alias = env->NewStringUTF("reveny");
-    jstring attestKeyAlias = useAttestKey ? env->NewStringUTF("reveny_persistent") : nullptr;
+    // The attest keys are meant to persist, only the per-run key is tracked and deleted again.
+    jstring attestKeyAlias = useAttestKey ? env->NewStringUTF(useStrongBox ? "reveny_strongbox_persistent" : "reveny_persistent") : nullptr;
 
-    jclass keyStoreClass = SAFE_FIND_CLASS(env, "java/security/KeyStore");
-    jmethodID getInstanceMethod = SAFE_GET_STATIC_METHOD_ID(env, keyStoreClass, "getInstance", "(Ljava/lang/String;)Ljava/security/KeyStore;");
-    jobject keyStore = env->CallStaticObjectMethod(keyStoreClass, getInstanceMethod, env->NewStringUTF("AndroidKeyStore"));
+    jobject keyStore = KeyStoreManager::GetKeyStore(env);
     SAFE_FAILIURE_RETURN_VALUE(env, keyStore, AttestationResult::Error);
 
-    jmethodID loadMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "load", "(Ljava/security/KeyStore$LoadStoreParameter;)V");
-    env->CallVoidMethod(keyStore, loadMethod, nullptr);
-    SAFE_JNI_CHECK_VALUE(env, AttestationResult::Error);
-
-    if (useAttestKey) {
-        jmethodID containsAliasMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "containsAlias", "(Ljava/lang/String;)Z");
-        jboolean hasAttestKey = env->CallBooleanMethod(keyStore, containsAliasMethod, attestKeyAlias);
-        SAFE_JNI_CHECK_VALUE(env, AttestationResult::Error);
-
-        if (!hasAttestKey) {
-            GenerateKey(env, attestKeyAlias, useStrongBox, includeProps, attestKeyAlias);
+    if (useAttestKey && !KeyStoreManager::ContainsAlias(env, attestKeyAlias)) {
+        if (!GenerateKey(env, attestKeyAlias, useStrongBox, includeProps, attestKeyAlias)) {
+            LOGE("StartAttestation -> Failed to generate attest key (StrongBox: %d)", useStrongBox);
+            return AttestationResult::Error;
         }
     }
-    GenerateKey(env, alias, useStrongBox, includeProps, attestKeyAlias);
 
-    jmethodID getCertificateChainMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "getCertificateChain", "(Ljava/lang/String;)[Ljava/security/cert/Certificate;");
-    jobjectArray certificateChain = static_cast<jobjectArray>(env->CallObjectMethod(keyStore, getCertificateChainMethod, useAttestKey ? attestKeyAlias : alias));
+    std::string keyAlias = KeyStoreManager::AcquireAlias(env, useStrongBox);
+    if (keyAlias.empty()) {
+        LOGE("StartAttestation -> No keystore slot available (StrongBox: %d)", useStrongBox);
+        return AttestationResult::Error;
+    }
+    jstring alias = env->NewStringUTF(keyAlias.c_str());
+
+    bool generated = GenerateKey(env, alias, useStrongBox, includeProps, attestKeyAlias);
+    jobjectArray certificateChain = generated ? KeyStoreManager::GetCertificateChain(env, useAttestKey ? attestKeyAlias : alias) : nullptr;
+
+    // The chain is all we need from the key, hand it back before the slow parsing starts.
+    KeyStoreManager::ReleaseAlias(env, keyAlias);
+
+    if (!generated) {
+        LOGE("StartAttestation -> Failed to generate key (StrongBox: %d)", useStrongBox);
+        return AttestationResult::Error;
+    }
     SAFE_FAILIURE_RETURN_VALUE(env, certificateChain, AttestationResult::Error);
 
     jclass certificateFactoryClass = SAFE_FIND_CLASS(env, "java/security/cert/CertificateFactory");
@@ -336,4 +410,104 @@ KeyAttestation::AttestationResult KeyAttestation::StartAttestation(JNIEnv* env,
 
     // LOGI("StartAttestation -> Size: %d", env->GetArrayLength(x509Certs));
     return ParseCertificateChain(env, x509Certs);
-}
\ No newline at end of file
+}
+
+KeyAttestation::SecurityLevelReport KeyAttestation::RunSecurityLevelAttestation(JNIEnv* env, jboolean useStrongBox, jboolean includeProps, jboolean useAttestKey) {
+    SecurityLevelReport report;
+    report.result = StartAttestation(env, useStrongBox, includeProps, useAttestKey);
+    report.available = report.result != AttestationResult::Error && report.result != AttestationResult::CriticalError;
+    if (!report.available) {
+        return report;
+    }
+
+    // Same priority as ParseCertificateChain, Tee first.
+    RootOfTrust* rootOfTrust = nullptr;
+    if (teeEnforced.get() != nullptr && teeEnforced->rootOfTrust != nullptr) {
+        rootOfTrust = teeEnforced->rootOfTrust;
+    } else if (softwareEnforced.get() != nullptr && softwareEnforced->rootOfTrust != nullptr) {
+        rootOfTrust = softwareEnforced->rootOfTrust;
+    }
+
+    report.securityLevel = attestationSecurityLevel;
+    report.outData = outData;
+    if (rootOfTrust != nullptr) {
+        report.verifiedBootState = rootOfTrust->getVerifiedBootState();
+        report.deviceLocked = rootOfTrust->isDeviceLocked();
+        report.verifiedBootKey = rootOfTrust->verifiedBootKey;
+    }
+
+    return report;
+}
+
+KeyAttestation::ParallelAttestationReport KeyAttestation::StartParallelAttestation(JNIEnv* env, jboolean includeProps, jboolean useAttestKey) {
+    ParallelAttestationReport report;
+
+    JavaVM* vm = nullptr;
+    if (env->GetJavaVM(&vm) != JNI_OK) {
+        return report;
+    }
+
+    // Must happen on a thread that can see the app classes, without it the worker cannot parse its chain.
+    bool hasClassLoader = SafeJNI::CacheClassLoader(env, "org/bouncycastle/asn1/ASN1Sequence");
+    if (!hasClassLoader) {
+        LOGE("StartParallelAttestation -> No app class loader, skipping StrongBox");
+    }
+
+    // StrongBox keygen is the slow one, so it runs on a worker while this thread handles the TEE.
+    // StrongBox only exists since Android 9, below that GenerateKey would silently fall back to the TEE.
+    std::thread strongBoxThread;
+    if (hasClassLoader && android_get_device_api_level() >= 28) {
+        strongBoxThread = std::thread([vm, includeProps, useAttestKey, &report]() {
+            JNIEnv* threadEnv = nullptr;
+            JavaVMAttachArgs args = { JNI_VERSION_1_6, "StrongBoxAttest", nullptr };
+            if (vm->AttachCurrentThread(&threadEnv, &args) != JNI_OK) {
+                LOGE("StartParallelAttestation -> Failed to attach StrongBox thread");
+                return;
+            }
+
+            report.strongBox = RunSecurityLevelAttestation(threadEnv, JNI_TRUE, includeProps, useAttestKey);
+            vm->DetachCurrentThread();
+        });
+    }
+
+    report.tee = RunSecurityLevelAttestation(env, JNI_FALSE, includeProps, useAttestKey);
+    if (strongBoxThread.joinable()) {
+        strongBoxThread.join();
+    }
+
+    auto FormatReport = [](const char* name, const SecurityLevelReport& levelReport) -> std::string {
+        if (!levelReport.available) {
+            return std::string(name) + ": Unavailable";
+        }
+
+        return std::string(name) + " (Security Level: " + SecurityLevelToString(levelReport.securityLevel) + ")\n"
+                + "Verified Boot State: " + RootOfTrust::VerifiedBootStateToString(levelReport.verifiedBootState) + "\n"
+                + "Is Device Locked: " + std::string(levelReport.deviceLocked ? "true" : "false");
+    };
+
+    // Keystore refuses StrongBox keygen without StrongBox, a chain attesting a lower level is a downgrade.
+    if (report.strongBox.available && report.strongBox.securityLevel != SecurityLevel::StrongBox) {
+        LOGE("StartParallelAttestation -> StrongBox key attested as %s", SecurityLevelToString(report.strongBox.securityLevel).c_str());
+        report.consistent = false;
+        report.result = AttestationResult::Unlocked;
+    } else if (report.tee.available && report.strongBox.available) {
+        // Both are rooted in the same bootloader, any disagreement means one of them is lying.
+        report.consistent = report.tee.securityLevel == SecurityLevel::TrustedEnvironment
+                && report.tee.verifiedBootState == report.strongBox.verifiedBootState
+                && report.tee.deviceLocked == report.strongBox.deviceLocked
+                && report.tee.verifiedBootKey == report.strongBox.verifiedBootKey;
+        report.result = *report.consistent ? report.strongBox.result : AttestationResult::Unlocked;
+    } else if (report.strongBox.available) {
+        report.result = report.strongBox.result;
+    } else if (report.tee.available) {
+        report.result = report.tee.result;
+    } else {
+        report.result = AttestationResult::Error;
+    }
+
+    report.outData = FormatReport("TEE", report.tee) + "\n\n"
+            + FormatReport("StrongBox", report.strongBox) + "\n\n"
+            + "Consistent: " + std::string(!report.consistent.has_value() ? "n/a" : *report.consistent ? "true" : "false");
+
+    return report;
+}
@@ -4,7 +4,11 @@
 #pragma once
 
 #include <jni.h>
+#include <memory>
+#include <optional>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "RootOfTrust.hpp"
 
@@ -14,6 +18,7 @@ namespace KeyAttestation {
     constexpr const int KM_TAG_ROOT_OF_TRUST = KM_BYTES | 704;
     constexpr const int KM_TAG_PURPOSE = KM_ENUM_REP | 1;
     constexpr const int KEYMASTER_TAG_TYPE_MASK = 0x0FFFFFFF;
+    constexpr const int ATTESTATION_SECURITY_LEVEL_INDEX = 1;
     constexpr const int ATTESTATION_CHALLENGE_INDEX = 4;
     constexpr const int SW_ENFORCED_INDEX = 6;
     constexpr const int TEE_ENFORCED_INDEX = 7;
@@ -22,7 +27,8 @@ namespace KeyAttestation {
     const std::string ASN1_OID = "1.3.6.1.4.1.11129.2.1.17";
     const std::string CRL_DP_OID = "2.5.29.31";
 
-    extern jbyteArray attestationChallenge;
+    // Parsing state is per thread so the TEE and StrongBox chains can be parsed concurrently.
+    extern thread_local std::vector<jbyte> attestationChallenge;
 
     enum AttestationResult {
         Error = -1,
@@ -30,8 +36,37 @@ namespace KeyAttestation {
         Locked = 1,
         Unlocked = 0,
     };
-    extern AttestationResult attestationResult;
-    extern std::string outData;
+    extern thread_local AttestationResult attestationResult;
+    extern thread_local std::string outData;
+
+    enum SecurityLevel {
+        Unknown = -1,
+        Software = 0,
+        TrustedEnvironment = 1,
+        StrongBox = 2,
+    };
+    extern thread_local SecurityLevel attestationSecurityLevel;
+    // Set once an attestation extension of the chain failed to decode, the chain then reports Error.
+    extern thread_local bool attestationMalformed;
+
+    struct SecurityLevelReport {
+        bool available = false;
+        AttestationResult result = AttestationResult::CriticalError;
+        SecurityLevel securityLevel = SecurityLevel::Unknown;
+        int verifiedBootState = -1;
+        bool deviceLocked = false;
+        std::vector<jbyte> verifiedBootKey;
+        std::string outData;
+    };
+
+    struct ParallelAttestationReport {
+        SecurityLevelReport tee;
+        SecurityLevelReport strongBox;
+        // Unset when only one security level could be attested and there was nothing to compare.
+        std::optional<bool> consistent;
+        AttestationResult result = AttestationResult::CriticalError;
+        std::string outData;
+    };
 
     jobject ParseAsn1Encodable(JNIEnv* env, jobject parser);
     jobject ParseAsn1TaggedObject(JNIEnv* env, jobject parser);
@@ -79,30 +114,47 @@ namespace KeyAttestation {
                         purposes = Asn1Utils::GetIntegersFromAsn1Set(env, value);
                         break;
                     case KM_TAG_ROOT_OF_TRUST & KEYMASTER_TAG_TYPE_MASK:
+                        delete rootOfTrust;
                         rootOfTrust = new RootOfTrust(env, value);
                         break;
                 }
 
+                // Never keep a half decoded root of trust, its defaults would be reported as real values.
+                // The exception stays pending so the caller fails the list instead of using what is left of it.
+                if (env->ExceptionCheck()) {
+                    delete rootOfTrust;
+                    rootOfTrust = nullptr;
+                    return;
+                }
+
                 entry = ParseAsn1TaggedObject(env, parser); // Move to the next entry
             }
         }
 
+        Attest(const Attest&) = delete;
+        Attest& operator=(const Attest&) = delete;
+
         ~Attest() {
             delete rootOfTrust; // Ensure proper cleanup
         }
     };
 
-    extern std::unique_ptr<Attest> softwareEnforced;
-    extern std::unique_ptr<Attest> teeEnforced;
+    extern thread_local std::unique_ptr<Attest> softwareEnforced;
+    extern thread_local std::unique_ptr<Attest> teeEnforced;
 
     void Asn1Attestation(JNIEnv* env, jobject cert);
+    void ParseAttestationSequence(JNIEnv* env, jobject seq);
     void LoadFromCert(JNIEnv* env, jobject cert);
-    std::string VerifiedBootStateToString(int verifiedBootState);
+    void ResetChainState();
+    std::string SecurityLevelToString(SecurityLevel securityLevel);
 
     void CheckStatus(JNIEnv* env, jobject cert, jobject parentKey);
     bool CheckAttestation(JNIEnv* env, jobject certificate);
-    void GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongBox, jboolean includeProps, jstring attestKeyAlias);
+    bool GenerateKey(JNIEnv* env, jstring alias, jboolean useStrongBox, jboolean includeProps, jstring attestKeyAlias);
 
     AttestationResult ParseCertificateChain(JNIEnv* env, jobjectArray certs);
     AttestationResult StartAttestation(JNIEnv* env, jboolean useStrongBox, jboolean includeProps, jboolean useAttestKey);
+
+    SecurityLevelReport RunSecurityLevelAttestation(JNIEnv* env, jboolean useStrongBox, jboolean includeProps, jboolean useAttestKey);
+    ParallelAttestationReport StartParallelAttestation(JNIEnv* env, jboolean includeProps, jboolean useAttestKey);
 }
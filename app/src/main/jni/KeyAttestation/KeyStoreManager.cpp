@@ -0,0 +1,265 @@
+//
+// Created by reveny on 19/10/2026.
+//
+#include "KeyStoreManager.hpp"
+#include "Include/Logger.hpp"
+#include "Include/SafeJNI.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace KeyStoreManager {
+    // keyStore is published once under stateMutex and never released, it lives as long as the process.
+    std::atomic<jobject> keyStore = nullptr;
+    JavaVM* javaVM = nullptr;
+
+    struct PendingDelete {
+        std::string alias;
+        int attempts = 0;
+    };
+
+    // Only serializes the first load, stateMutex is never held across keystore I/O.
+    std::mutex loadMutex;
+    std::mutex stateMutex;
+    std::condition_variable cleanupCondition;
+    std::set<std::string> liveAliases;
+    // Every alias this process handed out, the leak scan must never queue them.
+    std::set<std::string> issuedAliases;
+    std::deque<PendingDelete> pendingDeletes;
+    // Keys that survived MAX_DELETE_ATTEMPTS, they are still in the keystore and keep their slot.
+    std::set<std::string> undeletableAliases;
+    size_t inFlightDeletes = 0;
+    std::atomic<unsigned int> aliasCounter = 0;
+
+    size_t UsedSlots() { return liveAliases.size() + pendingDeletes.size() + inFlightDeletes + undeletableAliases.size(); }
+    void DeleteInFlight(JNIEnv* env, std::unique_lock<std::mutex>& lock, PendingDelete entry);
+
+    void CleanupThread();
+    void QueueLeakedAliases(JNIEnv* env);
+    std::vector<std::string> GetAliases(JNIEnv* env, jobject store);
+}
+
+std::vector<std::string> KeyStoreManager::GetAliases(JNIEnv* env, jobject store) {
+    std::vector<std::string> result;
+
+    jclass keyStoreClass = SAFE_FIND_CLASS(env, "java/security/KeyStore");
+    jmethodID aliasesMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "aliases", "()Ljava/util/Enumeration;");
+    SAFE_FAILIURE_RETURN_VALUE(env, aliasesMethod, result);
+
+    jobject enumeration = env->CallObjectMethod(store, aliasesMethod);
+    SAFE_FAILIURE_RETURN_VALUE(env, enumeration, result);
+
+    jclass enumerationClass = SAFE_FIND_CLASS(env, "java/util/Enumeration");
+    jmethodID hasMoreElementsMethod = SAFE_GET_METHOD_ID(env, enumerationClass, "hasMoreElements", "()Z");
+    jmethodID nextElementMethod = SAFE_GET_METHOD_ID(env, enumerationClass, "nextElement", "()Ljava/lang/Object;");
+    SAFE_FAILIURE_RETURN_VALUE(env, nextElementMethod, result);
+
+    while (env->CallBooleanMethod(enumeration, hasMoreElementsMethod)) {
+        jstring alias = (jstring)env->CallObjectMethod(enumeration, nextElementMethod);
+        SAFE_FAILIURE_RETURN_VALUE(env, alias, result);
+
+        const char* chars = env->GetStringUTFChars(alias, nullptr);
+        result.emplace_back(chars);
+        env->ReleaseStringUTFChars(alias, chars);
+        env->DeleteLocalRef(alias);
+    }
+    SAFE_JNI_CHECK_VALUE(env, result);
+
+    return result;
+}
+
+jobject KeyStoreManager::GetKeyStore(JNIEnv* env) {
+    if (jobject store = keyStore.load()) {
+        return store;
+    }
+
+    std::lock_guard<std::mutex> loadLock(loadMutex);
+    if (jobject store = keyStore.load()) {
+        return store;
+    }
+
+    jclass keyStoreClass = SAFE_FIND_CLASS(env, "java/security/KeyStore");
+    jmethodID getInstanceMethod = SAFE_GET_STATIC_METHOD_ID(env, keyStoreClass, "getInstance", "(Ljava/lang/String;)Ljava/security/KeyStore;");
+    SAFE_FAILIURE_RETURN_VALUE(env, getInstanceMethod, nullptr);
+
+    jobject store = env->CallStaticObjectMethod(keyStoreClass, getInstanceMethod, env->NewStringUTF("AndroidKeyStore"));
+    SAFE_FAILIURE_RETURN_VALUE(env, store, nullptr);
+
+    jmethodID loadMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "load", "(Ljava/security/KeyStore$LoadStoreParameter;)V");
+    SAFE_FAILIURE_RETURN_VALUE(env, loadMethod, nullptr);
+
+    env->CallVoidMethod(store, loadMethod, nullptr);
+    SAFE_JNI_CHECK_VALUE(env, nullptr);
+
+    JavaVM* vm = nullptr;
+    if (env->GetJavaVM(&vm) != JNI_OK) {
+        LOGE("GetKeyStore -> Failed to get JavaVM, keys will not be cleaned up");
+        vm = nullptr;
+    }
+
+    jobject globalStore = env->NewGlobalRef(store);
+    env->DeleteLocalRef(store);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        javaVM = vm;
+        keyStore = globalStore;
+    }
+
+    // Also scans for keys leaked by earlier processes, listing every alias is too slow for the attestation path.
+    if (vm != nullptr) {
+        std::thread(CleanupThread).detach();
+    }
+
+    return globalStore;
+}
+
+void KeyStoreManager::QueueLeakedAliases(JNIEnv* env) {
+    std::vector<std::string> aliases = GetAliases(env, keyStore.load());
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    for (const std::string& alias : aliases) {
+        bool legacy = std::find(std::begin(LEGACY_ALIASES), std::end(LEGACY_ALIASES), alias) != std::end(LEGACY_ALIASES);
+        if ((legacy || alias.rfind(ATTEST_ALIAS_PREFIX, 0) == 0) && issuedAliases.count(alias) == 0) {
+            pendingDeletes.push_back({ alias });
+        }
+    }
+}
+
+void KeyStoreManager::DeleteInFlight(JNIEnv* env, std::unique_lock<std::mutex>& lock, PendingDelete entry) {
+    // The key still occupies a keystore slot until deleteEntry returns, keep it counted until then.
+    inFlightDeletes++;
+    lock.unlock();
+    bool deleted = DeleteEntry(env, entry.alias);
+    lock.lock();
+    inFlightDeletes--;
+
+    if (deleted) {
+        return;
+    }
+
+    // A failed delete leaves the key in the keystore, so it never stops counting against the cap.
+    if (++entry.attempts < MAX_DELETE_ATTEMPTS) {
+        pendingDeletes.push_back(entry);
+        cleanupCondition.notify_one();
+    } else {
+        LOGE("DeleteInFlight -> Giving up on %s after %d attempts", entry.alias.c_str(), entry.attempts);
+        undeletableAliases.insert(entry.alias);
+    }
+}
+
+std::string KeyStoreManager::AcquireAlias(JNIEnv* env, bool strongBox) {
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string alias = ATTEST_ALIAS_PREFIX + (strongBox ? "strongbox_" : "tee_") + std::to_string(now) + "_" + std::to_string(aliasCounter++);
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    // Make room on the calling thread, waiting for the cleanup thread would not bound the entry count.
+    while (UsedSlots() >= MAX_KEYSTORE_ENTRIES && !pendingDeletes.empty()) {
+        PendingDelete old = pendingDeletes.front();
+        pendingDeletes.pop_front();
+        DeleteInFlight(env, lock, old);
+    }
+
+    // The caller is on the attestation path, fail right away instead of waiting for running deletions.
+    if (UsedSlots() >= MAX_KEYSTORE_ENTRIES) {
+        LOGE("AcquireAlias -> Entry cap reached (%zu live, %zu being deleted, %zu undeletable)", liveAliases.size(), inFlightDeletes, undeletableAliases.size());
+        return "";
+    }
+
+    liveAliases.insert(alias);
+    issuedAliases.insert(alias);
+    return alias;
+}
+
+void KeyStoreManager::ReleaseAlias(JNIEnv* env, const std::string& alias) {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    if (liveAliases.erase(alias) == 0) {
+        return;
+    }
+
+    if (javaVM != nullptr) {
+        pendingDeletes.push_back({ alias });
+        cleanupCondition.notify_one();
+        return;
+    }
+
+    // No cleanup thread, delete right away rather than leak the key.
+    DeleteInFlight(env, lock, { alias });
+}
+
+bool KeyStoreManager::ContainsAlias(JNIEnv* env, jstring alias) {
+    jobject store = GetKeyStore(env);
+    SAFE_FAILIURE_RETURN_VALUE(env, store, false);
+
+    jclass keyStoreClass = SAFE_FIND_CLASS(env, "java/security/KeyStore");
+    jmethodID containsAliasMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "containsAlias", "(Ljava/lang/String;)Z");
+    SAFE_FAILIURE_RETURN_VALUE(env, containsAliasMethod, false);
+
+    jboolean result = env->CallBooleanMethod(store, containsAliasMethod, alias);
+    SAFE_JNI_CHECK_VALUE(env, false);
+
+    return result;
+}
+
+jobjectArray KeyStoreManager::GetCertificateChain(JNIEnv* env, jstring alias) {
+    jobject store = GetKeyStore(env);
+    SAFE_FAILIURE_RETURN_VALUE(env, store, nullptr);
+
+    jclass keyStoreClass = SAFE_FIND_CLASS(env, "java/security/KeyStore");
+    jmethodID getCertificateChainMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "getCertificateChain", "(Ljava/lang/String;)[Ljava/security/cert/Certificate;");
+    SAFE_FAILIURE_RETURN_VALUE(env, getCertificateChainMethod, nullptr);
+
+    jobjectArray chain = static_cast<jobjectArray>(env->CallObjectMethod(store, getCertificateChainMethod, alias));
+    SAFE_JNI_CHECK_VALUE(env, nullptr);
+
+    return chain;
+}
+
+bool KeyStoreManager::DeleteEntry(JNIEnv* env, const std::string& alias) {
+    jobject store = GetKeyStore(env);
+    SAFE_FAILIURE_RETURN_VALUE(env, store, false);
+
+    jclass keyStoreClass = SAFE_FIND_CLASS(env, "java/security/KeyStore");
+    jmethodID deleteEntryMethod = SAFE_GET_METHOD_ID(env, keyStoreClass, "deleteEntry", "(Ljava/lang/String;)V");
+    SAFE_FAILIURE_RETURN_VALUE(env, deleteEntryMethod, false);
+
+    jstring jAlias = env->NewStringUTF(alias.c_str());
+    env->CallVoidMethod(store, deleteEntryMethod, jAlias);
+    env->DeleteLocalRef(jAlias);
+    env->DeleteLocalRef(keyStoreClass);
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOGE("DeleteEntry -> Failed to delete %s", alias.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void KeyStoreManager::CleanupThread() {
+    JNIEnv* env = nullptr;
+    JavaVMAttachArgs args = { JNI_VERSION_1_6, "KeyStoreCleanup", nullptr };
+    if (javaVM->AttachCurrentThreadAsDaemon(&env, &args) != JNI_OK) {
+        LOGE("CleanupThread -> Failed to attach, keys will not be cleaned up");
+        return;
+    }
+
+    QueueLeakedAliases(env);
+
+    // Runs for the lifetime of the process, keystore I/O stays off the attestation path.
+    while (true) {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        cleanupCondition.wait(lock, []() { return !pendingDeletes.empty(); });
+        PendingDelete entry = pendingDeletes.front();
+        pendingDeletes.pop_front();
+
+        DeleteInFlight(env, lock, entry);
+    }
+}
@@ -0,0 +1,33 @@
+//
+// Created by reveny on 19/10/2026.
+//
+#pragma once
+
+#include <jni.h>
+#include <string>
+
+namespace KeyStoreManager {
+    // Every per-run attestation key starts with this prefix so leaked keys from older runs can be found again.
+    const std::string ATTEST_ALIAS_PREFIX = "reveny_attest_";
+    // Alias used before keys were tracked, the cleanup thread removes it once it starts.
+    const std::string LEGACY_ALIASES[] = { "reveny" };
+
+    // Upper bound for per-run attestation keys, keystore latency grows with the entry count on some devices.
+    // Live keys, queued, running and failed deletions all count, the persistent attest keys and other entries do not.
+    constexpr const int MAX_KEYSTORE_ENTRIES = 8;
+    // A key that still cannot be deleted after this many tries is left to the next process.
+    constexpr const int MAX_DELETE_ATTEMPTS = 3;
+
+    // Returns the loaded AndroidKeyStore as a global reference, it is only loaded once per process.
+    jobject GetKeyStore(JNIEnv* env);
+
+    // Returns a fresh tracked alias, deleting queued keys first if the entry cap would be exceeded.
+    // Never waits, returns an empty string when every slot is taken.
+    std::string AcquireAlias(JNIEnv* env, bool strongBox);
+    // Hands an alias back, the key is deleted on the background cleanup thread.
+    void ReleaseAlias(JNIEnv* env, const std::string& alias);
+
+    bool ContainsAlias(JNIEnv* env, jstring alias);
+    jobjectArray GetCertificateChain(JNIEnv* env, jstring alias);
+    bool DeleteEntry(JNIEnv* env, const std::string& alias);
+}
@@ -20,19 +20,37 @@ public:
         KM_VERIFIED_BOOT_FAILED = 3,
     };
 
-    jbyteArray verifiedBootKey;
+    std::vector<jbyte> verifiedBootKey;
     bool deviceLocked = true;
-    VerifiedBootState verifiedBootState;
+    VerifiedBootState verifiedBootState = VerifiedBootState::KM_VERIFIED_BOOT_FAILED;
 
+    // On malformed input a Java exception is left pending and the remaining fields keep their defaults.
     RootOfTrust(JNIEnv *env, jobject asn1Encodable) {
-        jclass sequenceClass = env->FindClass("org/bouncycastle/asn1/ASN1Sequence");
-        if (!env->IsInstanceOf(asn1Encodable, sequenceClass)) {
-            SAFE_THROW(env, "java/lang/IllegalArgumentException", "Expected sequence for authorization list")
+        jclass sequenceClass = SAFE_FIND_CLASS(env, "org/bouncycastle/asn1/ASN1Sequence");
+        if (sequenceClass == nullptr || asn1Encodable == nullptr || !env->IsInstanceOf(asn1Encodable, sequenceClass)) {
+            SAFE_THROW(env, "java/lang/IllegalArgumentException", "Expected sequence for root of trust");
+            return;
         }
 
-        jmethodID getObjectAtMethod = env->GetMethodID(sequenceClass, "getObjectAt", "(I)Lorg/bouncycastle/asn1/ASN1Encodable;");
-        verifiedBootKey = Asn1Utils::GetByteArrayFromAsn1(env, env->CallObjectMethod(asn1Encodable, getObjectAtMethod, VERIFIED_BOOT_KEY_INDEX));
+        jmethodID sizeMethod = SAFE_GET_METHOD_ID(env, sequenceClass, "size", "()I");
+        if (sizeMethod == nullptr) return;
+
+        jint size = env->CallIntMethod(asn1Encodable, sizeMethod);
+        if (env->ExceptionCheck()) return;
+        if (size <= VERIFIED_BOOT_STATE_INDEX) {
+            SAFE_THROW(env, "java/lang/IllegalArgumentException", "Root of trust sequence too short");
+            return;
+        }
+
+        jmethodID getObjectAtMethod = SAFE_GET_METHOD_ID(env, sequenceClass, "getObjectAt", "(I)Lorg/bouncycastle/asn1/ASN1Encodable;");
+        if (getObjectAtMethod == nullptr) return;
+
+        verifiedBootKey = Asn1Utils::GetBytesFromAsn1(env, env->CallObjectMethod(asn1Encodable, getObjectAtMethod, VERIFIED_BOOT_KEY_INDEX));
+        if (env->ExceptionCheck()) return;
+
         deviceLocked = Asn1Utils::GetBooleanFromAsn1(env, env->CallObjectMethod(asn1Encodable, getObjectAtMethod, DEVICE_LOCKED_INDEX));
+        if (env->ExceptionCheck()) return;
+
         verifiedBootState = (VerifiedBootState) Asn1Utils::GetIntegerFromAsn1(env, env->CallObjectMethod(asn1Encodable, getObjectAtMethod, VERIFIED_BOOT_STATE_INDEX));
     }
 
@@ -45,11 +63,17 @@ public:
     }
 
     std::string getVerifiedBootStateString() {
+        return VerifiedBootStateToString(verifiedBootState);
+    }
+
+    // Shared with reports that only kept the raw state, so every report words it the same.
+    static std::string VerifiedBootStateToString(int verifiedBootState) {
         switch (verifiedBootState) {
             case VerifiedBootState::KM_VERIFIED_BOOT_VERIFIED: return "Verified";
             case VerifiedBootState::KM_VERIFIED_BOOT_SELF_SIGNED: return "Self Signed";
             case VerifiedBootState::KM_VERIFIED_BOOT_UNVERIFIED: return "Unverified";
             case VerifiedBootState::KM_VERIFIED_BOOT_FAILED: return "Failed";
+            default: return "Unknown (" + std::to_string(verifiedBootState) + ")";
         }
     }
 };
\ No newline at end of file
@@ -17,4 +17,16 @@ extern "C" {
 
         return env->NewStringUTF(KeyAttestation::outData.c_str());
     }
+
+    JNIEXPORT jstring JNICALL
+    Java_com_reveny_nativekeyattestation_MainActivity_getParallelAttestationResult(JNIEnv *env, jobject thiz)
+    {
+        KeyAttestation::ParallelAttestationReport report = KeyAttestation::StartParallelAttestation(env, false, false);
+
+        if (report.result == KeyAttestation::AttestationResult::Error || report.result == KeyAttestation::AttestationResult::CriticalError) {
+            return env->NewStringUTF("Could not run Attestation. See Log for reason.");
+        }
+
+        return env->NewStringUTF(report.outData.c_str());
+    }
 }
\ No newline at end of file
@@ -0,0 +1,235 @@
+//
+// Created by reveny on 19/10/2026.
+//
+#include "FuzzHost.hpp"
+#include "KeyAttestation/KeyAttestation.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+// The JVM needs its own SIGSEGV handler for implicit null checks and leaks by design.
+extern "C" const char* __asan_default_options() {
+    return "handle_segv=0:allow_user_segv_handler=1:detect_leaks=0";
+}
+
+namespace FuzzHost {
+    JavaVM* javaVM = nullptr;
+    JNIEnv* mainEnv = nullptr;
+
+    constexpr const char* REFERENCE_DECODER_CLASS = "com/reveny/nativekeyattestation/fuzz/ReferenceDecoder";
+
+    std::string ToHex(const std::vector<jbyte>& bytes) {
+        static const char digits[] = "0123456789abcdef";
+
+        std::string result;
+        for (jbyte b : bytes) {
+            result += digits[(b >> 4) & 0xF];
+            result += digits[b & 0xF];
+        }
+        return result;
+    }
+
+    std::string DumpRootOfTrust(RootOfTrust* rootOfTrust) {
+        if (rootOfTrust == nullptr) return "none";
+
+        // Not part of the dump, but this used to fall off the end of the function for unknown states.
+        (void)rootOfTrust->getVerifiedBootStateString();
+
+        return ToHex(rootOfTrust->verifiedBootKey) + "," + (rootOfTrust->isDeviceLocked() ? "true" : "false") + "," + std::to_string(rootOfTrust->getVerifiedBootState());
+    }
+
+    std::string DumpAuthorizationList(const std::string& name, KeyAttestation::Attest* attest) {
+        std::string purposes;
+        for (int purpose : attest->purposes) {
+            if (!purposes.empty()) purposes += ",";
+            purposes += std::to_string(purpose);
+        }
+
+        return name + ".purposes=" + purposes + "\n"
+                + name + ".rootOfTrust=" + DumpRootOfTrust(attest->rootOfTrust) + "\n";
+    }
+
+    jobject ReadPrimitive(JNIEnv* env, jbyteArray bytes) {
+        jclass asn1InputStreamClass = SAFE_FIND_CLASS(env, "org/bouncycastle/asn1/ASN1InputStream");
+        jmethodID constructor = SAFE_GET_METHOD_ID(env, asn1InputStreamClass, "<init>", "([B)V");
+        jmethodID readObjectMethod = SAFE_GET_METHOD_ID(env, asn1InputStreamClass, "readObject", "()Lorg/bouncycastle/asn1/ASN1Primitive;");
+        SAFE_FAILIURE_RETURN_VALUE(env, readObjectMethod, nullptr);
+
+        jobject stream = env->NewObject(asn1InputStreamClass, constructor, bytes);
+        SAFE_FAILIURE_RETURN_VALUE(env, stream, nullptr);
+
+        jobject primitive = env->CallObjectMethod(stream, readObjectMethod);
+        SAFE_FAILIURE_RETURN_VALUE(env, primitive, nullptr);
+
+        return primitive;
+    }
+
+    std::map<std::string, std::string> SplitFields(const std::string& dump) {
+        std::map<std::string, std::string> fields;
+        std::istringstream stream(dump);
+        std::string line;
+        while (std::getline(stream, line)) {
+            size_t separator = line.find('=');
+            fields[line.substr(0, separator)] = separator == std::string::npos ? "" : line.substr(separator + 1);
+        }
+        return fields;
+    }
+
+    void ReportMismatch(const std::string& reference, const std::string& native) {
+        fprintf(stderr, "==DIFFERENTIAL MISMATCH== BouncyCastle and native decoder disagree\n");
+        if (native.empty()) {
+            fprintf(stderr, "  native decoder rejected an input BouncyCastle accepts:\n%s", reference.c_str());
+            return;
+        }
+        if (reference.empty()) {
+            fprintf(stderr, "  native decoder accepted an input BouncyCastle rejects:\n%s", native.c_str());
+            return;
+        }
+
+        std::map<std::string, std::string> referenceFields = SplitFields(reference);
+        std::map<std::string, std::string> nativeFields = SplitFields(native);
+        for (const auto& [field, value] : referenceFields) {
+            auto it = nativeFields.find(field);
+            std::string nativeValue = it == nativeFields.end() ? "<missing>" : it->second;
+            if (nativeValue != value) {
+                fprintf(stderr, "  %s: BouncyCastle=%s native=%s\n", field.c_str(), value.c_str(), nativeValue.c_str());
+            }
+        }
+        for (const auto& [field, value] : nativeFields) {
+            if (referenceFields.find(field) == referenceFields.end()) {
+                fprintf(stderr, "  %s: BouncyCastle=<missing> native=%s\n", field.c_str(), value.c_str());
+            }
+        }
+    }
+}
+
+JNIEnv* FuzzHost::GetEnv() {
+    // Created lazily from the first input so the JVM installs its signal handlers after libFuzzer.
+    static std::once_flag once;
+    std::call_once(once, []() {
+        std::vector<JavaVMOption> options;
+        options.push_back({ const_cast<char*>("-Djava.class.path=" FUZZ_CLASSPATH), nullptr });
+#if FUZZ_CHECK_JNI
+        options.push_back({ const_cast<char*>("-Xcheck:jni"), nullptr });
+#endif
+
+        JavaVMInitArgs args = {};
+        args.version = JNI_VERSION_1_6;
+        args.nOptions = (jint)options.size();
+        args.options = options.data();
+        args.ignoreUnrecognized = JNI_FALSE;
+
+        if (JNI_CreateJavaVM(&javaVM, (void**)&mainEnv, &args) != JNI_OK) {
+            fprintf(stderr, "FuzzHost -> Failed to create the JVM, classpath: %s\n", FUZZ_CLASSPATH);
+            abort();
+        }
+    });
+
+    return mainEnv;
+}
+
+std::string FuzzHost::DecodeNative(JNIEnv* env, Decoder decoder, jbyteArray bytes) {
+    std::string result;
+    switch (decoder) {
+        case Decoder::AttestationExtension: {
+            KeyAttestation::ResetChainState();
+
+            jobject seq = Asn1Utils::GetAsn1SequenceFromBytes(env, bytes);
+            if (seq == nullptr || env->ExceptionCheck()) break;
+
+            KeyAttestation::ParseAttestationSequence(env, seq);
+            if (env->ExceptionCheck() || KeyAttestation::attestationMalformed || !KeyAttestation::softwareEnforced || !KeyAttestation::teeEnforced) break;
+
+            result = "securityLevel=" + std::to_string(KeyAttestation::attestationSecurityLevel) + "\n"
+                    + "challenge=" + ToHex(KeyAttestation::attestationChallenge) + "\n"
+                    + DumpAuthorizationList("software", KeyAttestation::softwareEnforced.get())
+                    + DumpAuthorizationList("tee", KeyAttestation::teeEnforced.get());
+            break;
+        }
+        case Decoder::AuthorizationList: {
+            jobject primitive = ReadPrimitive(env, bytes);
+            if (primitive == nullptr) break;
+
+            KeyAttestation::Attest attest(env, primitive);
+            if (env->ExceptionCheck()) break;
+
+            result = DumpAuthorizationList("list", &attest);
+            break;
+        }
+        case Decoder::RootOfTrust: {
+            jobject primitive = ReadPrimitive(env, bytes);
+            if (primitive == nullptr) break;
+
+            RootOfTrust rootOfTrust(env, primitive);
+            if (env->ExceptionCheck()) break;
+
+            result = "rootOfTrust=" + DumpRootOfTrust(&rootOfTrust) + "\n";
+            break;
+        }
+    }
+
+    env->ExceptionClear();
+    return result;
+}
+
+std::string FuzzHost::DecodeReference(JNIEnv* env, Decoder decoder, jbyteArray bytes) {
+    const char* method = "decodeExtension";
+    switch (decoder) {
+        case Decoder::AttestationExtension: method = "decodeExtension"; break;
+        case Decoder::AuthorizationList: method = "decodeAuthorizationList"; break;
+        case Decoder::RootOfTrust: method = "decodeRootOfTrust"; break;
+    }
+
+    jclass referenceClass = env->FindClass(REFERENCE_DECODER_CLASS);
+    jmethodID decodeMethod = referenceClass ? env->GetStaticMethodID(referenceClass, method, "([B)Ljava/lang/String;") : nullptr;
+    if (decodeMethod == nullptr) {
+        env->ExceptionDescribe();
+        fprintf(stderr, "FuzzHost -> %s.%s not found on the classpath\n", REFERENCE_DECODER_CLASS, method);
+        abort();
+    }
+
+    jstring dump = (jstring)env->CallStaticObjectMethod(referenceClass, decodeMethod, bytes);
+    if (dump == nullptr || env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return "";
+    }
+
+    const char* chars = env->GetStringUTFChars(dump, nullptr);
+    std::string result(chars);
+    env->ReleaseStringUTFChars(dump, chars);
+    return result;
+}
+
+void FuzzHost::Run(Decoder decoder, const uint8_t* data, size_t size, bool differential) {
+    JNIEnv* env = GetEnv();
+
+    // Every input gets its own local frame, the decoders do not release their local references.
+    if (env->PushLocalFrame(512) != JNI_OK) {
+        env->ExceptionClear();
+        return;
+    }
+
+    jbyteArray bytes = env->NewByteArray((jsize)size);
+    env->SetByteArrayRegion(bytes, 0, (jsize)size, reinterpret_cast<const jbyte*>(data));
+
+    std::string native = DecodeNative(env, decoder, bytes);
+    if (differential) {
+        std::string reference = DecodeReference(env, decoder, bytes);
+
+        // Also a mismatch when BouncyCastle rejects an input the native decoder still dumps,
+        // that is how a half decoded authorization list shows up.
+        if (native != reference) {
+            ReportMismatch(reference, native);
+            abort();
+        }
+    }
+
+    if (decoder == Decoder::AttestationExtension) {
+        KeyAttestation::ResetChainState();
+    }
+    env->PopLocalFrame(nullptr);
+}
@@ -0,0 +1,29 @@
+//
+// Created by reveny on 19/10/2026.
+//
+#pragma once
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace FuzzHost {
+    enum class Decoder {
+        AttestationExtension, // Extension value as returned by X509Certificate.getExtensionValue
+        AuthorizationList,    // DER AuthorizationList sequence, decoded by KeyAttestation::Attest
+        RootOfTrust,          // DER RootOfTrust sequence, decoded by RootOfTrust
+    };
+
+    // Starts the host JVM with bcprov and the reference decoder on the classpath on first use.
+    JNIEnv* GetEnv();
+
+    // Canonical field dump of the native decoder, empty if the input was rejected.
+    std::string DecodeNative(JNIEnv* env, Decoder decoder, jbyteArray bytes);
+    // Same dump produced by plain BouncyCastle (ReferenceDecoder.java), empty if the input was rejected.
+    std::string DecodeReference(JNIEnv* env, Decoder decoder, jbyteArray bytes);
+
+    // Decodes one input. In differential mode every field is compared against the reference and the
+    // process aborts on the first mismatch so the fuzzer keeps the input.
+    void Run(Decoder decoder, const uint8_t* data, size_t size, bool differential);
+}
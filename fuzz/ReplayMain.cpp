@@ -0,0 +1,111 @@
+//
+// Created by reveny on 19/10/2026.
+//
+// Standalone driver for the fuzz targets, used when libFuzzer is not available and for throughput tracking.
+// Replays every file of the given corpora and reports executions per second.
+//
+// Usage: replay_<target> [-runs=N] [-min_exec_per_sec=N] [-exec_log=file] <file|directory>...
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+    std::vector<std::vector<uint8_t>> LoadInputs(const std::vector<std::string>& paths) {
+        std::vector<std::filesystem::path> files;
+        for (const std::string& path : paths) {
+            if (std::filesystem::is_directory(path)) {
+                for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+                    if (entry.is_regular_file()) files.push_back(entry.path());
+                }
+            } else {
+                files.emplace_back(path);
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        std::vector<std::vector<uint8_t>> inputs;
+        for (const auto& file : files) {
+            std::ifstream stream(file, std::ios::binary);
+            if (!stream) {
+                fprintf(stderr, "replay -> Cannot read %s\n", file.c_str());
+                exit(1);
+            }
+            inputs.emplace_back(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+        return inputs;
+    }
+
+    bool ParseFlag(const char* arg, const char* name, std::string& value) {
+        size_t length = strlen(name);
+        if (strncmp(arg, name, length) != 0 || arg[length] != '=') return false;
+
+        value = arg + length + 1;
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    long runs = 1;
+    double minExecPerSec = 0;
+    std::string execLog;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        std::string value;
+        if (ParseFlag(argv[i], "-runs", value)) runs = std::max(1L, strtol(value.c_str(), nullptr, 10));
+        else if (ParseFlag(argv[i], "-min_exec_per_sec", value)) minExecPerSec = strtod(value.c_str(), nullptr);
+        else if (ParseFlag(argv[i], "-exec_log", value)) execLog = value;
+        else if (argv[i][0] == '-') fprintf(stderr, "replay -> Ignoring unknown flag %s\n", argv[i]);
+        else paths.emplace_back(argv[i]);
+    }
+
+    std::vector<std::vector<uint8_t>> inputs = LoadInputs(paths);
+    if (inputs.empty()) {
+        fprintf(stderr, "replay -> No inputs\n");
+        return 1;
+    }
+
+    // One untimed pass so JVM startup and JIT warm-up do not count against the parser.
+    for (const auto& input : inputs) {
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (long run = 0; run < runs; run++) {
+        for (const auto& input : inputs) {
+            LLVMFuzzerTestOneInput(input.data(), input.size());
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long executions = runs * (long)inputs.size();
+    double execPerSec = seconds > 0 ? executions / seconds : 0;
+    printf("stat::number_of_executed_units: %ld\n", executions);
+    printf("stat::exec_per_sec: %.0f\n", execPerSec);
+
+    if (!execLog.empty()) {
+        FILE* log = fopen(execLog.c_str(), "a");
+        if (log != nullptr) {
+            fprintf(log, "%ld,%s,%ld,%.3f,%.0f\n", (long)time(nullptr), std::filesystem::path(argv[0]).filename().c_str(), executions, seconds, execPerSec);
+            fclose(log);
+        }
+    }
+
+    if (execPerSec < minExecPerSec) {
+        fprintf(stderr, "replay -> %.0f exec/s is below the minimum of %.0f, the parser got slower\n", execPerSec, minExecPerSec);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""Seed corpus tool for the attestation fuzz targets.
+
+  seeds.py generate            Rebuild the synthetic seeds in the corpus directories.
+  seeds.py extract CHAIN...    Split device attestation chains (PEM or DER certificates) into seeds.
+
+Each corpus directory matches one fuzz target:
+  attestation_extension/  extension value as returned by X509Certificate.getExtensionValue
+  authorization_list/     softwareEnforced / teeEnforced AuthorizationList sequences
+  root_of_trust/          RootOfTrust sequences
+"""
+import base64
+import hashlib
+import os
+import re
+import sys
+
+CORPUS_DIR = os.path.dirname(os.path.abspath(__file__))
+KEY_DESCRIPTION_OID = "1.3.6.1.4.1.11129.2.1.17"
+
+
+def encode_length(length):
+    if length < 0x80:
+        return bytes([length])
+    body = length.to_bytes((length.bit_length() + 7) // 8, "big")
+    return bytes([0x80 | len(body)]) + body
+
+
+def tlv(tag, content):
+    return tag + encode_length(len(content)) + content
+
+
+def integer(value, tag=b"\x02"):
+    return tlv(tag, value.to_bytes(max(1, (value.bit_length() + 8) // 8), "big", signed=True))
+
+
+def enumerated(value):
+    return integer(value, b"\x0a")
+
+
+def octets(value):
+    return tlv(b"\x04", value)
+
+
+def boolean(value):
+    return tlv(b"\x01", b"\xff" if value else b"\x00")
+
+
+def sequence(*items):
+    return tlv(b"\x30", b"".join(items))
+
+
+def set_of(*items):
+    return tlv(b"\x31", b"".join(sorted(items)))
+
+
+def explicit(number, content):
+    # Constructed context-specific tag, KeyMint tag numbers above 30 use the high-tag-number form.
+    if number < 31:
+        return tlv(bytes([0xA0 | number]), content)
+    digits = []
+    while True:
+        digits.insert(0, number & 0x7F)
+        number >>= 7
+        if number == 0:
+            break
+    digits = [d | 0x80 for d in digits[:-1]] + [digits[-1]]
+    return tlv(bytes([0xBF] + digits), content)
+
+
+def root_of_trust(locked, state, key=None, boot_hash=True):
+    # verifiedBootHash was added in Keymaster 4 (attestationVersion 3).
+    key = key if key is not None else hashlib.sha256(b"verified boot key").digest()
+    items = [octets(key), boolean(locked), enumerated(state)]
+    if boot_hash:
+        items.append(octets(hashlib.sha256(b"vbmeta").digest()))
+    return sequence(*items)
+
+
+def authorization_list(purposes=None, rot=None, extra=()):
+    items = []
+    if purposes is not None:
+        items.append(explicit(1, set_of(*[integer(p) for p in purposes])))
+    items += [
+        explicit(2, integer(3)),      # algorithm: EC
+        explicit(3, integer(256)),    # key size
+        explicit(5, set_of(integer(4))),  # digest: SHA-256
+        explicit(10, integer(1)),     # EC curve: P-256
+        explicit(503, tlv(b"\x05", b"")),  # no auth required
+        explicit(702, integer(0)),    # origin: generated
+    ]
+    if rot is not None:
+        items.append(explicit(704, rot))
+    items += [explicit(705, integer(140000)), explicit(706, integer(202410))]
+    items += list(extra)
+    return sequence(*items)
+
+
+def key_description(security_level, challenge, software, tee, version=200, keymaster_version=None):
+    # KeyMint uses the same number for both, Keymaster attestation versions 2/3 belong to Keymaster 3/4.
+    keymaster_version = keymaster_version if keymaster_version is not None else version
+    return sequence(
+        integer(version), enumerated(security_level),
+        integer(keymaster_version), enumerated(security_level),
+        octets(challenge), octets(b""),
+        software, tee,
+    )
+
+
+def extension_value(description):
+    return octets(description)
+
+
+def synthetic_seeds():
+    challenge = b"Sat Oct 19 12:00:00 GMT 2026"
+    software = authorization_list(extra=[explicit(701, integer(1760875200000)), explicit(709, octets(b"com.reveny.nativekeyattestation"))])
+    locked = root_of_trust(True, 0)
+    unlocked = root_of_trust(False, 2)
+
+    seeds = {
+        "attestation_extension": {
+            "tee_locked_verified": key_description(1, challenge, software, authorization_list([2, 3], locked)),
+            "tee_unlocked_unverified": key_description(1, challenge, software, authorization_list([2, 3], unlocked)),
+            "strongbox_locked_verified": key_description(2, challenge, software, authorization_list([2, 3], locked)),
+            "software_only_root_of_trust": key_description(0, challenge, authorization_list([2, 3], locked), authorization_list()),
+            "attest_key_purpose": key_description(1, challenge, software, authorization_list([7], locked)),
+            "unknown_boot_state": key_description(1, challenge, software, authorization_list([2, 3], root_of_trust(True, 7))),
+            "keymaster3": key_description(1, challenge, software, authorization_list([2, 3], root_of_trust(True, 0, boot_hash=False)), version=2, keymaster_version=3),
+            "keymaster4": key_description(1, challenge, software, authorization_list([2, 3], locked), version=3, keymaster_version=4),
+        },
+        "authorization_list": {
+            "tee_locked": authorization_list([2, 3], locked),
+            "tee_unlocked": authorization_list([2, 3], unlocked),
+            "software": software,
+            "empty": sequence(),
+        },
+        "root_of_trust": {
+            "locked_verified": locked,
+            "unlocked_unverified": unlocked,
+            "self_signed": root_of_trust(True, 1),
+            "failed": root_of_trust(False, 3),
+            "unknown_state": root_of_trust(True, 7),
+            "keymaster3_no_hash": root_of_trust(True, 0, key=b"\x00" * 32, boot_hash=False),
+        },
+    }
+    seeds["attestation_extension"] = {name: extension_value(value) for name, value in seeds["attestation_extension"].items()}
+    return seeds
+
+
+def write_seeds(directory, name, data):
+    path = os.path.join(CORPUS_DIR, directory)
+    os.makedirs(path, exist_ok=True)
+    with open(os.path.join(path, name), "wb") as f:
+        f.write(data)
+
+
+def read_tlv(data, offset):
+    tag_start = offset
+    offset += 1
+    if data[tag_start] & 0x1F == 0x1F:
+        while data[offset] & 0x80:
+            offset += 1
+        offset += 1
+    tag = data[tag_start:offset]
+
+    length = data[offset]
+    offset += 1
+    if length & 0x80:
+        count = length & 0x7F
+        length = int.from_bytes(data[offset:offset + count], "big")
+        offset += count
+    return tag, data[offset:offset + length], data[tag_start:offset + length], offset + length
+
+
+def children(content):
+    offset = 0
+    while offset < len(content):
+        tag, value, raw, offset = read_tlv(content, offset)
+        yield tag, value, raw
+
+
+def decode_oid(value):
+    parts = [value[0] // 40, value[0] % 40]
+    number = 0
+    for b in value[1:]:
+        number = (number << 7) | (b & 0x7F)
+        if not b & 0x80:
+            parts.append(number)
+            number = 0
+    return ".".join(str(p) for p in parts)
+
+
+def extension_of(certificate):
+    _, cert, _, _ = read_tlv(certificate, 0)
+    _, tbs, _, _ = read_tlv(cert, 0)
+    for tag, value, _ in children(tbs):
+        if tag != b"\xa3":
+            continue
+        _, extensions, _, _ = read_tlv(value, 0)
+        for _, extension, _ in children(extensions):
+            fields = list(children(extension))
+            if decode_oid(fields[0][1]) == KEY_DESCRIPTION_OID:
+                return fields[-1][2]
+    return None
+
+
+def load_certificates(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    pems = re.findall(rb"-----BEGIN CERTIFICATE-----(.+?)-----END CERTIFICATE-----", data, re.S)
+    if pems:
+        return [base64.b64decode(b"".join(pem.split())) for pem in pems]
+
+    certificates = []
+    offset = 0
+    while offset < len(data):
+        _, _, raw, offset = read_tlv(data, offset)
+        certificates.append(raw)
+    return certificates
+
+
+def extract(paths):
+    for path in paths:
+        base = os.path.splitext(os.path.basename(path))[0]
+        for index, certificate in enumerate(load_certificates(path)):
+            extension = extension_of(certificate)
+            if extension is None:
+                continue
+
+            name = "%s_%d" % (base, index)
+            write_seeds("attestation_extension", name, extension)
+
+            _, description, _, _ = read_tlv(extension, 0)
+            _, fields, _, _ = read_tlv(description, 0)
+            fields = list(children(fields))
+            for list_name, (_, list_value, list_raw) in (("software", fields[6]), ("tee", fields[7])):
+                write_seeds("authorization_list", "%s_%s" % (name, list_name), list_raw)
+                for tag, value, _ in children(list_value):
+                    if tag == b"\xbf\x85\x40":
+                        write_seeds("root_of_trust", "%s_%s" % (name, list_name), value)
+            print("%s: certificate %d -> %s" % (path, index, name))
+
+
+def main():
+    if len(sys.argv) >= 2 and sys.argv[1] == "generate":
+        for directory, seeds in synthetic_seeds().items():
+            for name, data in seeds.items():
+                write_seeds(directory, "synthetic_" + name, data)
+    elif len(sys.argv) >= 3 and sys.argv[1] == "extract":
+        extract(sys.argv[2:])
+    else:
+        print(__doc__.strip())
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
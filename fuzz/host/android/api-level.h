@@ -0,0 +1,9 @@
+//
+// Created by reveny on 19/10/2026.
+//
+#pragma once
+
+// Keygen paths are never reached on the host, report the targetSdk so they behave like on a current device.
+inline int android_get_device_api_level() {
+    return 34;
+}
@@ -0,0 +1,30 @@
+//
+// Created by reveny on 19/10/2026.
+//
+#pragma once
+
+// Host stand-in for the NDK header so the decoders build on Linux. Logging is silent unless FUZZ_VERBOSE is set,
+// malformed inputs would otherwise flood the fuzzer output.
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+// Bionic pulls this in through every system header, the decoder sources rely on that.
+#include <android/api-level.h>
+
+enum {
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_ERROR = 6,
+};
+
+inline int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    if (getenv("FUZZ_VERBOSE") == nullptr) return 0;
+
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "[%s] ", tag);
+    int written = vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    return written;
+}
@@ -0,0 +1,170 @@
+package com.reveny.nativekeyattestation.fuzz;
+
+import org.bouncycastle.asn1.ASN1Boolean;
+import org.bouncycastle.asn1.ASN1Encodable;
+import org.bouncycastle.asn1.ASN1Enumerated;
+import org.bouncycastle.asn1.ASN1InputStream;
+import org.bouncycastle.asn1.ASN1Integer;
+import org.bouncycastle.asn1.ASN1OctetString;
+import org.bouncycastle.asn1.ASN1Primitive;
+import org.bouncycastle.asn1.ASN1Sequence;
+import org.bouncycastle.asn1.ASN1Set;
+import org.bouncycastle.asn1.ASN1TaggedObject;
+import org.bouncycastle.asn1.DEROctetString;
+
+import java.io.IOException;
+import java.math.BigInteger;
+import java.util.Enumeration;
+import java.util.Set;
+import java.util.TreeSet;
+
+/**
+ * Reference side of the differential fuzz targets. Decodes with plain BouncyCastle following the rules
+ * of the original Java KeyAttestation and prints the same canonical dump as FuzzHost.cpp.
+ * Every method returns null for input it rejects.
+ */
+public final class ReferenceDecoder {
+    private static final int ATTESTATION_SECURITY_LEVEL_INDEX = 1;
+    private static final int ATTESTATION_CHALLENGE_INDEX = 4;
+    private static final int SW_ENFORCED_INDEX = 6;
+    private static final int TEE_ENFORCED_INDEX = 7;
+
+    private static final int KM_TAG_PURPOSE = 1;
+    private static final int KM_TAG_ROOT_OF_TRUST = 704;
+
+    private ReferenceDecoder() {
+    }
+
+    public static String decodeExtension(byte[] bytes) {
+        try {
+            ASN1Primitive extension = readObject(bytes);
+            if (!(extension instanceof ASN1OctetString)) return null;
+
+            ASN1Primitive primitive = readObject(((ASN1OctetString) extension).getOctets());
+            if (!(primitive instanceof ASN1Sequence)) return null;
+
+            ASN1Sequence sequence = (ASN1Sequence) primitive;
+            if (sequence.size() <= TEE_ENFORCED_INDEX) return null;
+
+            StringBuilder out = new StringBuilder();
+            out.append("securityLevel=").append(getInteger(sequence.getObjectAt(ATTESTATION_SECURITY_LEVEL_INDEX))).append('\n');
+            out.append("challenge=").append(toHex(getOctets(sequence.getObjectAt(ATTESTATION_CHALLENGE_INDEX)))).append('\n');
+            appendAuthorizationList(out, "software", sequence.getObjectAt(SW_ENFORCED_INDEX));
+            appendAuthorizationList(out, "tee", sequence.getObjectAt(TEE_ENFORCED_INDEX));
+            return out.toString();
+        } catch (IOException | RuntimeException e) {
+            return null;
+        }
+    }
+
+    public static String decodeAuthorizationList(byte[] bytes) {
+        try {
+            StringBuilder out = new StringBuilder();
+            appendAuthorizationList(out, "list", readObject(bytes));
+            return out.toString();
+        } catch (IOException | RuntimeException e) {
+            return null;
+        }
+    }
+
+    public static String decodeRootOfTrust(byte[] bytes) {
+        try {
+            return "rootOfTrust=" + rootOfTrust(readObject(bytes)) + "\n";
+        } catch (IOException | RuntimeException e) {
+            return null;
+        }
+    }
+
+    private static ASN1Primitive readObject(byte[] bytes) throws IOException {
+        try (ASN1InputStream stream = new ASN1InputStream(bytes)) {
+            ASN1Primitive primitive = stream.readObject();
+            if (primitive == null) throw new IOException("Empty input");
+            return primitive;
+        }
+    }
+
+    private static void appendAuthorizationList(StringBuilder out, String name, ASN1Encodable encodable) {
+        if (!(encodable instanceof ASN1Sequence)) throw new IllegalArgumentException("Expected sequence for authorization list");
+
+        Set<Integer> purposes = new TreeSet<>();
+        String rootOfTrust = "none";
+        for (ASN1Encodable entry : (ASN1Sequence) encodable) {
+            if (!(entry instanceof ASN1TaggedObject)) throw new IllegalArgumentException("Expected ASN1TaggedObject");
+
+            ASN1TaggedObject tagged = (ASN1TaggedObject) entry;
+            switch (tagged.getTagNo()) {
+                case KM_TAG_PURPOSE:
+                    purposes = getIntegers(tagged.getBaseObject());
+                    break;
+                case KM_TAG_ROOT_OF_TRUST:
+                    rootOfTrust = rootOfTrust(tagged.getBaseObject());
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        StringBuilder joined = new StringBuilder();
+        for (int purpose : purposes) {
+            if (joined.length() > 0) joined.append(',');
+            joined.append(purpose);
+        }
+        out.append(name).append(".purposes=").append(joined).append('\n');
+        out.append(name).append(".rootOfTrust=").append(rootOfTrust).append('\n');
+    }
+
+    private static String rootOfTrust(ASN1Encodable encodable) {
+        if (!(encodable instanceof ASN1Sequence)) throw new IllegalArgumentException("Expected sequence for root of trust");
+
+        ASN1Sequence sequence = (ASN1Sequence) encodable;
+        byte[] verifiedBootKey = getOctets(sequence.getObjectAt(0));
+        boolean deviceLocked = getBoolean(sequence.getObjectAt(1));
+        int verifiedBootState = getInteger(sequence.getObjectAt(2));
+        return toHex(verifiedBootKey) + "," + deviceLocked + "," + verifiedBootState;
+    }
+
+    private static byte[] getOctets(ASN1Encodable encodable) {
+        if (!(encodable instanceof DEROctetString)) throw new IllegalArgumentException("Expected DEROctetString");
+        return ((DEROctetString) encodable).getOctets();
+    }
+
+    private static boolean getBoolean(ASN1Encodable encodable) {
+        if (!(encodable instanceof ASN1Boolean)) throw new IllegalArgumentException("Expected boolean");
+        return ((ASN1Boolean) encodable).isTrue();
+    }
+
+    private static int getInteger(ASN1Encodable encodable) {
+        BigInteger value;
+        if (encodable instanceof ASN1Integer) {
+            value = ((ASN1Integer) encodable).getValue();
+        } else if (encodable instanceof ASN1Enumerated) {
+            value = ((ASN1Enumerated) encodable).getValue();
+        } else {
+            throw new IllegalArgumentException("Integer value expected");
+        }
+
+        if (value.compareTo(BigInteger.ZERO) < 0 || value.compareTo(BigInteger.valueOf(Integer.MAX_VALUE)) > 0) {
+            throw new IllegalArgumentException("INTEGER out of bounds");
+        }
+        return value.intValue();
+    }
+
+    private static Set<Integer> getIntegers(ASN1Encodable encodable) {
+        if (!(encodable instanceof ASN1Set)) throw new IllegalArgumentException("Expected set");
+
+        Set<Integer> result = new TreeSet<>();
+        Enumeration<?> objects = ((ASN1Set) encodable).getObjects();
+        while (objects.hasMoreElements()) {
+            result.add(getInteger((ASN1Encodable) objects.nextElement()));
+        }
+        return result;
+    }
+
+    private static String toHex(byte[] bytes) {
+        StringBuilder out = new StringBuilder(bytes.length * 2);
+        for (byte b : bytes) {
+            out.append(Character.forDigit((b >> 4) & 0xF, 16)).append(Character.forDigit(b & 0xF, 16));
+        }
+        return out.toString();
+    }
+}
@@ -0,0 +1,10 @@
+//
+// Created by reveny on 19/10/2026.
+//
+#include "FuzzHost.hpp"
+
+// libFuzzer entry point for the attestation extension value decoder.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    FuzzHost::Run(FuzzHost::Decoder::AttestationExtension, data, size, FUZZ_DIFFERENTIAL);
+    return 0;
+}